@@ -33,6 +33,7 @@
 #include <stdbool.h>
 #include <math.h>
 #include <float.h>
+#include <string.h>
 
 #include "degridder.h"
 
@@ -59,6 +60,12 @@ void init_config(Config *config)
 	// Number of visibilities to process
 	config->num_visibilities = 1;
 	
+	// Convolve each unique (grid center, kernel offset, w-plane) footprint once
+	config->coalesce_footprints = false;
+	
+	// Number of consecutive visibilities sharing one footprint table (bounds memory)
+	config->coalesce_chunk_size = 65536;
+	
 	// File location to load grid
 	config->grid_real_source_file = "../data/grid_real.csv";
 	config->grid_imag_source_file = "../data/grid_imag.csv";
@@ -75,84 +82,180 @@ void init_config(Config *config)
 }
 
 void execute_degridding(Config *config, Complex *grid, Visibility *vis_uvw, Complex *vis_intensities, Complex *kernel, int num_visibilities)
+{
+	Footprint footprint;
+	
+	for(int vis_index = 0; vis_index < num_visibilities; ++vis_index)
+	{
+		footprint = calculate_footprint(config, vis_uvw[vis_index]);
+		vis_intensities[vis_index] = degrid_footprint(config, grid, kernel, footprint);
+	}
+}
+
+double execute_degridding_coalesced(Config *config, Complex *grid, Visibility *vis_uvw, Complex *vis_intensities, Complex *kernel, int num_visibilities)
+{
+	if(num_visibilities <= 0)
+		return 1.0;
+	
+	// Coalesce within fixed size chunks so table memory stays bounded
+	int chunk_size = config->coalesce_chunk_size;
+	if(chunk_size <= 0 || chunk_size > num_visibilities)
+		chunk_size = num_visibilities;
+	
+	// Open addressing table, at least twice the chunk size (power of two)
+	size_t table_size = 1;
+	while(table_size < 2 * (size_t) chunk_size)
+		table_size <<= 1;
+	size_t table_mask = table_size - 1;
+	
+	FootprintEntry *table = (FootprintEntry*) calloc(table_size, sizeof(FootprintEntry));
+	if(!table)
+	{
+		printf("Unable to allocate footprint table, degridding without coalescing...\n");
+		execute_degridding(config, grid, vis_uvw, vis_intensities, kernel, num_visibilities);
+		return 1.0;
+	}
+	
+	Footprint footprint;
+	FootprintEntry *entry = NULL;
+	int num_unique_footprints = 0;
+	size_t table_index = 0;
+	
+	for(int chunk_start = 0; chunk_start < num_visibilities; chunk_start += chunk_size)
+	{
+		int chunk_end = (num_visibilities - chunk_start > chunk_size) ? chunk_start + chunk_size : num_visibilities;
+		
+		// Footprints are only shared within the current chunk
+		if(chunk_start > 0)
+			memset(table, 0, table_size * sizeof(FootprintEntry));
+		
+		for(int vis_index = chunk_start; vis_index < chunk_end; ++vis_index)
+		{
+			footprint = calculate_footprint(config, vis_uvw[vis_index]);
+			table_index = hash_footprint(footprint) & table_mask;
+			
+			// Linear probe until matching footprint or empty slot found
+			entry = &table[table_index];
+			while(entry->occupied && !footprints_equal(entry->footprint, footprint))
+			{
+				table_index = (table_index + 1) & table_mask;
+				entry = &table[table_index];
+			}
+			
+			// Only convolve footprints not yet seen, otherwise fan out cached result
+			if(!entry->occupied)
+			{
+				entry->occupied = true;
+				entry->footprint = footprint;
+				entry->visibility = degrid_footprint(config, grid, kernel, footprint);
+				++num_unique_footprints;
+			}
+			
+			vis_intensities[vis_index] = entry->visibility;
+		}
+	}
+	
+	free(table);
+	
+	// Ratio of visibilities to convolutions performed (1.0 == no duplicates)
+	return (double) num_visibilities / num_unique_footprints;
+}
+
+Footprint calculate_footprint(Config *config, Visibility vis)
 {
 	double uv_scale = config->uv_scale;
+	int half_grid_size = config->grid_size / 2;
+	int oversampling = config->oversampling;
+	
+	double grid_u = vis.u * uv_scale;
+	double grid_v = vis.v * uv_scale;
+	
+	Footprint footprint;
+	// Calculate the central grid point of current visibility
+	footprint.grid_u_center = round(grid_u) + half_grid_size;
+	footprint.grid_v_center = round(grid_v) + half_grid_size;
+	// Calculate the sub-pixel offsets (in grid units) into the oversampled kernel
+	footprint.kernel_u_offset = (int) round((grid_u - round(grid_u)) * oversampling);
+	footprint.kernel_v_offset = (int) round((grid_v - round(grid_v)) * oversampling);
+	// Single w == 0 kernel plane is currently supported
+	footprint.w_plane = 0;
+	return footprint;
+}
+
+Complex degrid_footprint(Config *config, Complex *grid, Complex *kernel, Footprint footprint)
+{
 	int grid_size = config->grid_size;
-	int half_grid_size = grid_size / 2;
 	int kernel_size = config->kernel_size;
 	int half_kernel_size = (kernel_size - 1) / 2; // 4
 	int oversampling = config->oversampling;
 	
-	Visibility current_vis;
-	int vis_grid_u_center = 0;
-	int vis_grid_v_center = 0;
-	
-	int grid_u_start = 0;
-	int grid_v_start = 0;
-	int grid_u_end = 0;
-	int grid_v_end = 0;
 	int grid_index = 0;
-	
-	int kernel_u = 0;
-	int kernel_v = 0;
-	int kernel_u_offset = 0;
-	int kernel_v_offset = 0;
 	int kernel_index = 0;
 	
 	Complex current_grid_point;
 	Complex current_kernel_point;
 	Complex grid_kernel_product;
-	Complex predicted_visibility;
-	
-	for(int vis_index = 0; vis_index < num_visibilities; ++vis_index)
-	{
-		predicted_visibility = (Complex) {.real = 0.0, .imag = 0.0};
-		current_vis = vis_uvw[vis_index];
-		// Calculate the central grid point of current visibility
-		vis_grid_u_center = round(current_vis.u * uv_scale) + half_grid_size;
-		vis_grid_v_center = round(current_vis.v * uv_scale) + half_grid_size;
-		// Calculate the starting indices for the convolution kernel
-		grid_u_start = vis_grid_u_center - half_kernel_size;
-		grid_u_end = vis_grid_u_center + half_kernel_size;
-		grid_v_start = vis_grid_v_center - half_kernel_size;
-		grid_v_end = vis_grid_v_center + half_kernel_size;
-		
-		kernel_u_offset = (int) round((current_vis.u - (int) current_vis.u) * oversampling);
-		kernel_v_offset = (int) round((current_vis.v - (int) current_vis.v) * oversampling);
-		//printf("U offset: %d, V offset: %d\n", kernel_u_offset, kernel_v_offset);
-		kernel_u = -half_kernel_size * oversampling + kernel_u_offset;
-		kernel_v = -half_kernel_size * oversampling + kernel_v_offset;
-		
-		// Iterate over grid, extracting convolved values
-		for(int grid_v = grid_v_start; grid_v <= grid_v_end; ++grid_v, kernel_v += oversampling)
-		{	
-			for(int grid_u = grid_u_start; grid_u <= grid_u_end; ++grid_u, kernel_u += oversampling)
-			{
-				// Get grid point
-				grid_index = grid_v * grid_size + grid_u;
-				current_grid_point = grid[grid_index];				
-				
-				// Get kernel sample
-				kernel_index = abs(kernel_v * half_kernel_size) * 5 + abs(kernel_u);
-				
-				//printf("Grid R/C: %d, %d = %f+%f\n", grid_v, grid_u, current_grid_point.real, current_grid_point.imag);
-				current_kernel_point = kernel[kernel_index];
-				
-				// printf("Colonel V/U (index): %d, %d, %d\n", kernel_v, kernel_u, kernel_index);
-				// Calculate complex product
-				grid_kernel_product = complex_multiply(current_grid_point, current_kernel_point);
-				// Add complex product to predicted visibility
-				predicted_visibility.real += grid_kernel_product.real;
-				predicted_visibility.imag += grid_kernel_product.imag;  
-			}
+	Complex predicted_visibility = (Complex) {.real = 0.0, .imag = 0.0};
+	
+	// Calculate the starting indices for the convolution kernel
+	int grid_u_start = footprint.grid_u_center - half_kernel_size;
+	int grid_u_end = footprint.grid_u_center + half_kernel_size;
+	int grid_v_start = footprint.grid_v_center - half_kernel_size;
+	int grid_v_end = footprint.grid_v_center + half_kernel_size;
+	
+	//printf("U offset: %d, V offset: %d\n", footprint.kernel_u_offset, footprint.kernel_v_offset);
+	int kernel_u = -half_kernel_size * oversampling - footprint.kernel_u_offset;
+	int kernel_v = -half_kernel_size * oversampling - footprint.kernel_v_offset;
+	
+	// Iterate over grid, extracting convolved values
+	for(int grid_v = grid_v_start; grid_v <= grid_v_end; ++grid_v, kernel_v += oversampling)
+	{	
+		for(int grid_u = grid_u_start; grid_u <= grid_u_end; ++grid_u, kernel_u += oversampling)
+		{
+			// Get grid point
+			grid_index = grid_v * grid_size + grid_u;
+			current_grid_point = grid[grid_index];				
+			
+			// Get kernel sample
+			kernel_index = abs(kernel_v * half_kernel_size) * 5 + abs(kernel_u);
+			
+			//printf("Grid R/C: %d, %d = %f+%f\n", grid_v, grid_u, current_grid_point.real, current_grid_point.imag);
+			current_kernel_point = kernel[kernel_index];
 			
-			// Reset kernel index
-			kernel_u = -half_kernel_size * oversampling + kernel_u_offset;
+			// printf("Colonel V/U (index): %d, %d, %d\n", kernel_v, kernel_u, kernel_index);
+			// Calculate complex product
+			grid_kernel_product = complex_multiply(current_grid_point, current_kernel_point);
+			// Add complex product to predicted visibility
+			predicted_visibility.real += grid_kernel_product.real;
+			predicted_visibility.imag += grid_kernel_product.imag;  
 		}
 		
-		//printf("Predicted Vis: %f+%f\n", predicted_visibility.real, predicted_visibility.imag);
-		vis_intensities[vis_index] = predicted_visibility;
+		// Reset kernel index
+		kernel_u = -half_kernel_size * oversampling - footprint.kernel_u_offset;
 	}
+	
+	//printf("Predicted Vis: %f+%f\n", predicted_visibility.real, predicted_visibility.imag);
+	return predicted_visibility;
+}
+
+unsigned int hash_footprint(Footprint footprint)
+{
+	unsigned int hash = 2166136261u;
+	hash = (hash ^ (unsigned int) footprint.grid_u_center) * 16777619u;
+	hash = (hash ^ (unsigned int) footprint.grid_v_center) * 16777619u;
+	hash = (hash ^ (unsigned int) footprint.kernel_u_offset) * 16777619u;
+	hash = (hash ^ (unsigned int) footprint.kernel_v_offset) * 16777619u;
+	hash = (hash ^ (unsigned int) footprint.w_plane) * 16777619u;
+	return hash;
+}
+
+bool footprints_equal(Footprint f1, Footprint f2)
+{
+	return f1.grid_u_center == f2.grid_u_center
+		&& f1.grid_v_center == f2.grid_v_center
+		&& f1.kernel_u_offset == f2.kernel_u_offset
+		&& f1.kernel_v_offset == f2.kernel_v_offset
+		&& f1.w_plane == f2.w_plane;
 }
 
 void save_visibilities(Config *config, Visibility *vis_uvw, Complex *vis_intensity)
@@ -342,10 +445,10 @@ Complex complex_multiply(Complex z1, Complex z2)
 
 void clean_up(Complex **grid, Visibility **vis_uvw, Complex **vis_intensities, Complex **kernel)
 {
-	if(*grid) 			 free(*grid);
-	if(*vis_uvw) 	 	 free(*vis_uvw);
-	if(*vis_intensities) free(*vis_intensities);
-	if(*kernel) 		 free(*kernel);
+	if(grid && *grid) 			 	 free(*grid);
+	if(vis_uvw && *vis_uvw) 	 	 free(*vis_uvw);
+	if(vis_intensities && *vis_intensities) free(*vis_intensities);
+	if(kernel && *kernel) 		 	 free(*kernel);
 }
 
 /***************************************
@@ -362,6 +465,8 @@ void unit_test_init_config(Config *config)
 	config->oversampling = 4;
 	config->uv_scale = config->grid_size * config->cell_size;
 	config->num_visibilities = 1;
+	config->coalesce_footprints = false;
+	config->coalesce_chunk_size = 65536;
 	config->grid_real_source_file = "../data/grid_real.csv";
 	config->grid_imag_source_file = "../data/grid_imag.csv";
 	config->kernel_real_source_file = "../data/wproj_kernel_real.csv";
@@ -441,4 +546,70 @@ double unit_test_generate_approximate_visibilities(void)
 	}
 
 	return difference;	
-}
\ No newline at end of file
+}
+
+double unit_test_coalesce_duplicate_footprints(int chunk_size, double *dedup_ratio)
+{
+	// used to invalidate the unit test
+	double error = DBL_MAX;
+	*dedup_ratio = 0.0;
+
+	Config config;
+	unit_test_init_config(&config);
+	// Small synthetic grid, one grid cell per wavelength
+	config.grid_size = 64;
+	config.cell_size = 1.0 / config.grid_size;
+	config.uv_scale = config.grid_size * config.cell_size;
+	config.num_visibilities = 64;
+	config.coalesce_chunk_size = chunk_size;
+
+	Complex *grid = (Complex*) calloc(config.grid_size * config.grid_size, sizeof(Complex));
+	size_t kernel_size = pow(((config.kernel_size / 2) + 1) * config.oversampling, 2.0);
+	Complex *kernel = (Complex*) calloc(kernel_size, sizeof(Complex));
+	Visibility *vis_uvw = (Visibility*) calloc(config.num_visibilities, sizeof(Visibility));
+	Complex *vis_intensities = (Complex*) calloc(config.num_visibilities, sizeof(Complex));
+	Complex *coalesced_intensities = (Complex*) calloc(config.num_visibilities, sizeof(Complex));
+
+	if(!grid || !kernel || !vis_uvw || !vis_intensities || !coalesced_intensities)
+	{
+		clean_up(&grid, &vis_uvw, &vis_intensities, &kernel);
+		free(coalesced_intensities);
+		return error;
+	}
+
+	for(int grid_index = 0; grid_index < config.grid_size * config.grid_size; ++grid_index)
+		grid[grid_index] = (Complex) {.real = sin(grid_index * 0.37), .imag = cos(grid_index * 0.11)};
+
+	for(size_t kernel_index = 0; kernel_index < kernel_size; ++kernel_index)
+		kernel[kernel_index] = (Complex) {.real = 1.0 / (1.0 + kernel_index), .imag = 0.5 / (2.0 + kernel_index)};
+
+	// Eight distinct footprints, each repeated eight times (sub-pixel jitter within one footprint)
+	for(int vis_index = 0; vis_index < config.num_visibilities; ++vis_index)
+	{
+		int footprint_index = vis_index % 8;
+		double jitter = (vis_index / 8) * 1e-3;
+		vis_uvw[vis_index] = (Visibility) {
+			.u = -12.0 + 3.0 * footprint_index + 0.25 + jitter,
+			.v = 7.0 - 2.0 * footprint_index + 0.3 + jitter,
+			.w = 0.0
+		};
+	}
+
+	execute_degridding(&config, grid, vis_uvw, vis_intensities, kernel, config.num_visibilities);
+	*dedup_ratio = execute_degridding_coalesced(&config, grid, vis_uvw, coalesced_intensities, kernel, config.num_visibilities);
+
+	double difference = 0.0;
+
+	for(int vis_index = 0; vis_index < config.num_visibilities; ++vis_index)
+	{
+		double current_difference = sqrt(pow(coalesced_intensities[vis_index].real - vis_intensities[vis_index].real, 2.0)
+			+ pow(coalesced_intensities[vis_index].imag - vis_intensities[vis_index].imag, 2.0));
+
+		if(current_difference > difference)
+			difference = current_difference;
+	}
+
+	clean_up(&grid, &vis_uvw, &vis_intensities, &kernel);
+	free(coalesced_intensities);
+	return difference;
+}
@@ -48,6 +48,8 @@ extern "C" {
 		int oversampling;
 		double uv_scale;
 		int num_visibilities;
+		bool coalesce_footprints;
+		int coalesce_chunk_size;
 		char *grid_real_source_file;
 		char *grid_imag_source_file;
 		char *kernel_real_source_file;
@@ -67,6 +69,20 @@ extern "C" {
 		double imag;
 	} Complex;
 
+	typedef struct Footprint {
+		int grid_u_center;
+		int grid_v_center;
+		int kernel_u_offset;
+		int kernel_v_offset;
+		int w_plane;
+	} Footprint;
+
+	typedef struct FootprintEntry {
+		bool occupied;
+		Footprint footprint;
+		Complex visibility;
+	} FootprintEntry;
+
 void init_config(Config *config);
 
 bool load_grid(Config *config, Complex *grid);
@@ -77,6 +93,16 @@ void save_visibilities(Config *config, Visibility *vis_uvw, Complex *vis_intensi
 
 void execute_degridding(Config *config, Complex *grid, Visibility *vis_uvw, Complex *vis_intensities, Complex *kernel, int num_visibilities);
 
+double execute_degridding_coalesced(Config *config, Complex *grid, Visibility *vis_uvw, Complex *vis_intensities, Complex *kernel, int num_visibilities);
+
+Footprint calculate_footprint(Config *config, Visibility vis);
+
+Complex degrid_footprint(Config *config, Complex *grid, Complex *kernel, Footprint footprint);
+
+unsigned int hash_footprint(Footprint footprint);
+
+bool footprints_equal(Footprint f1, Footprint f2);
+
 bool load_kernel(Config *config, Complex *kernel);
 
 Complex complex_multiply(Complex z1, Complex z2);
@@ -87,6 +113,8 @@ void unit_test_init_config(Config *config);
 
 double unit_test_generate_approximate_visibilities(void);
 
+double unit_test_coalesce_duplicate_footprints(int chunk_size, double *dedup_ratio);
+
 #endif // DEGRIDDER_H_
 
 #ifdef __cplusplus
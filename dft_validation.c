@@ -0,0 +1,285 @@
+
+// Copyright 2019 Adam Campbell, Seth Hall, Andrew Ensor
+// Copyright 2019 High Performance Computing Research Laboratory, Auckland University of Technology (AUT)
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <float.h>
+
+#include "degridder.h"
+#include "dft_validation.h"
+
+// Every degridding engine and precision mode, with its permitted rms and max error
+// against the DFT (dominated by kernel offset quantisation at an oversampling of 4),
+// and against the direct double precision engine on the same inputs (double modes
+// should agree to rounding, float modes to roughly 1e-5)
+const ValidationEngine validation_engines[] = {
+	{"direct (double)",    false, 2.5e-2, 1e-1, 1e-12, 1e-12},
+	{"coalesced (double)", true,  2.5e-2, 1e-1, 1e-12, 1e-12},
+};
+
+const int num_validation_engines = sizeof(validation_engines) / sizeof(validation_engines[0]);
+
+void validation_init_config(Config *config)
+{
+	unit_test_init_config(config);
+	// Small synthetic grid, uvw coordinates supplied in wavelengths
+	config->grid_size = 256;
+	config->cell_size = 1.0 / (4.0 * config->grid_size);
+	config->uv_scale = config->grid_size * config->cell_size;
+	config->num_visibilities = 1 << 16;
+}
+
+void generate_sky_model(Config *config, Source *sources, int num_sources, unsigned int seed)
+{
+	srand(seed);
+	// Keep sources within the inner eighth of the field, away from aliasing
+	double max_offset = config->grid_size * config->cell_size / 8.0;
+	
+	for(int source_index = 0; source_index < num_sources; ++source_index)
+	{
+		sources[source_index] = (Source) {
+			.l = max_offset * (2.0 * rand() / RAND_MAX - 1.0),
+			.m = max_offset * (2.0 * rand() / RAND_MAX - 1.0),
+			.intensity = 1.0 / num_sources * (0.5 + (double) rand() / RAND_MAX)
+		};
+	}
+}
+
+void generate_uvw_samples(Config *config, Visibility *vis_uvw, int num_visibilities, unsigned int seed)
+{
+	srand(seed);
+	int half_kernel_size = (config->kernel_size - 1) / 2;
+	// Keep full convolution footprint within the grid
+	double max_uv = (config->grid_size / 2 - half_kernel_size - 1) / config->uv_scale;
+	
+	for(int vis_index = 0; vis_index < num_visibilities; ++vis_index)
+	{
+		vis_uvw[vis_index] = (Visibility) {
+			.u = max_uv * (2.0 * rand() / RAND_MAX - 1.0),
+			.v = max_uv * (2.0 * rand() / RAND_MAX - 1.0),
+			.w = 0.0
+		};
+	}
+}
+
+void direct_fourier_transform(Source *sources, int num_sources, Visibility *vis_uvw, Complex *vis_intensities, int num_visibilities)
+{
+	Visibility current_vis;
+	Source current_source;
+	double n = 0.0;
+	double phase = 0.0;
+	
+	for(int vis_index = 0; vis_index < num_visibilities; ++vis_index)
+	{
+		current_vis = vis_uvw[vis_index];
+		Complex visibility = (Complex) {.real = 0.0, .imag = 0.0};
+		
+		for(int source_index = 0; source_index < num_sources; ++source_index)
+		{
+			current_source = sources[source_index];
+			n = sqrt(1.0 - current_source.l * current_source.l - current_source.m * current_source.m);
+			phase = -2.0 * M_PI * (current_vis.u * current_source.l + current_vis.v * current_source.m
+				+ current_vis.w * (n - 1.0));
+			visibility.real += current_source.intensity * cos(phase);
+			visibility.imag += current_source.intensity * sin(phase);
+		}
+		
+		vis_intensities[vis_index] = visibility;
+	}
+}
+
+double validation_kernel_sample(Config *config, double distance)
+{
+	// Exponential of semicircle kernel, distance in grid units
+	double half_width = config->kernel_size / 2.0;
+	double beta = 2.3 * config->kernel_size;
+	double ratio = distance / half_width;
+	
+	if(fabs(ratio) >= 1.0)
+		return 0.0;
+	
+	return exp(beta * (sqrt(1.0 - ratio * ratio) - 1.0));
+}
+
+double validation_kernel_transform(Config *config, double frequency)
+{
+	// Numerical fourier transform of kernel, frequency in cycles per grid cell
+	double half_width = config->kernel_size / 2.0;
+	int steps_per_cell = 64;
+	int num_steps = (int) (half_width * steps_per_cell);
+	double step = 1.0 / steps_per_cell;
+	double transform = validation_kernel_sample(config, 0.0);
+	
+	for(int step_index = 1; step_index <= num_steps; ++step_index)
+	{
+		double distance = step_index * step;
+		transform += 2.0 * validation_kernel_sample(config, distance) * cos(2.0 * M_PI * distance * frequency);
+	}
+	
+	return transform * step;
+}
+
+void generate_validation_kernel(Config *config, Complex *kernel)
+{
+	int oversampling = config->oversampling;
+	int half_kernel_oversampled = ((config->kernel_size / 2) + 1) * oversampling;
+	int kernel_index = 0;
+	
+	// Quarter kernel, matching the layout produced by load_kernel
+	for(int row_index = 0; row_index < half_kernel_oversampled; ++row_index)
+	{
+		for(int col_index = 0; col_index < half_kernel_oversampled; ++col_index)
+		{
+			kernel_index = row_index * half_kernel_oversampled + col_index;
+			kernel[kernel_index] = (Complex) {
+				.real = validation_kernel_sample(config, (double) row_index / oversampling)
+					* validation_kernel_sample(config, (double) col_index / oversampling),
+				.imag = 0.0
+			};
+		}
+	}
+}
+
+void generate_corrected_grid(Config *config, Source *sources, int num_sources, Complex *grid)
+{
+	int grid_size = config->grid_size;
+	int half_grid_size = grid_size / 2;
+	double uv_scale = config->uv_scale;
+	
+	for(int grid_index = 0; grid_index < grid_size * grid_size; ++grid_index)
+		grid[grid_index] = (Complex) {.real = 0.0, .imag = 0.0};
+	
+	for(int source_index = 0; source_index < num_sources; ++source_index)
+	{
+		Source current_source = sources[source_index];
+		// Undo the taper applied by degridding with the validation kernel
+		double correction = validation_kernel_transform(config, current_source.l / uv_scale)
+			* validation_kernel_transform(config, current_source.m / uv_scale);
+		double intensity = current_source.intensity / correction;
+		
+		for(int grid_v = 0; grid_v < grid_size; ++grid_v)
+		{
+			for(int grid_u = 0; grid_u < grid_size; ++grid_u)
+			{
+				double phase = -2.0 * M_PI * ((grid_u - half_grid_size) * current_source.l
+					+ (grid_v - half_grid_size) * current_source.m) / uv_scale;
+				grid[grid_v * grid_size + grid_u].real += intensity * cos(phase);
+				grid[grid_v * grid_size + grid_u].imag += intensity * sin(phase);
+			}
+		}
+	}
+}
+
+void calculate_error(Complex *approx_intensities, Complex *exact_intensities, int num_visibilities, double *rms_error, double *max_error)
+{
+	double sum_squared = 0.0;
+	*max_error = 0.0;
+	
+	for(int vis_index = 0; vis_index < num_visibilities; ++vis_index)
+	{
+		double squared = pow(approx_intensities[vis_index].real - exact_intensities[vis_index].real, 2.0)
+			+ pow(approx_intensities[vis_index].imag - exact_intensities[vis_index].imag, 2.0);
+		sum_squared += squared;
+		
+		if(sqrt(squared) > *max_error)
+			*max_error = sqrt(squared);
+	}
+	
+	*rms_error = (num_visibilities > 0) ? sqrt(sum_squared / num_visibilities) : 0.0;
+}
+
+double execute_validation_engine(Config *config, const ValidationEngine *engine, Complex *grid, Visibility *vis_uvw, Complex *vis_intensities, Complex *kernel)
+{
+	if(engine->coalesced)
+		return execute_degridding_coalesced(config, grid, vis_uvw, vis_intensities, kernel, config->num_visibilities);
+	
+	execute_degridding(config, grid, vis_uvw, vis_intensities, kernel, config->num_visibilities);
+	return 1.0;
+}
+
+/***************************************
+*      UNIT TESTING FUNCTIONALITY      *
+***************************************/
+
+ValidationErrors unit_test_validate_engine(const ValidationEngine *engine)
+{
+	// used to invalidate the unit test
+	ValidationErrors errors = (ValidationErrors) {
+		.rms_error = DBL_MAX,
+		.max_error = DBL_MAX,
+		.reference_rms_error = DBL_MAX,
+		.reference_max_error = DBL_MAX
+	};
+
+	Config config;
+	validation_init_config(&config);
+	config.num_visibilities = 4096;
+	int num_sources = 8;
+
+	Source *sources = (Source*) calloc(num_sources, sizeof(Source));
+	Complex *grid = (Complex*) calloc(config.grid_size * config.grid_size, sizeof(Complex));
+	size_t kernel_size = pow(((config.kernel_size / 2) + 1) * config.oversampling, 2.0);
+	Complex *kernel = (Complex*) calloc(kernel_size, sizeof(Complex));
+	Visibility *vis_uvw = (Visibility*) calloc(config.num_visibilities, sizeof(Visibility));
+	Complex *vis_intensities = (Complex*) calloc(config.num_visibilities, sizeof(Complex));
+	Complex *exact_intensities = (Complex*) calloc(config.num_visibilities, sizeof(Complex));
+	Complex *reference_intensities = (Complex*) calloc(config.num_visibilities, sizeof(Complex));
+
+	if(!sources || !grid || !kernel || !vis_uvw || !vis_intensities || !exact_intensities || !reference_intensities)
+	{
+		clean_up(&grid, &vis_uvw, &vis_intensities, &kernel);
+		free(sources);
+		free(exact_intensities);
+		free(reference_intensities);
+		return errors;
+	}
+
+	generate_sky_model(&config, sources, num_sources, 1234);
+	generate_validation_kernel(&config, kernel);
+	generate_corrected_grid(&config, sources, num_sources, grid);
+	generate_uvw_samples(&config, vis_uvw, config.num_visibilities, 5678);
+	direct_fourier_transform(sources, num_sources, vis_uvw, exact_intensities, config.num_visibilities);
+	execute_degridding(&config, grid, vis_uvw, reference_intensities, kernel, config.num_visibilities);
+
+	execute_validation_engine(&config, engine, grid, vis_uvw, vis_intensities, kernel);
+
+	calculate_error(vis_intensities, exact_intensities, config.num_visibilities,
+		&errors.rms_error, &errors.max_error);
+	calculate_error(vis_intensities, reference_intensities, config.num_visibilities,
+		&errors.reference_rms_error, &errors.reference_max_error);
+
+	clean_up(&grid, &vis_uvw, &vis_intensities, &kernel);
+	free(sources);
+	free(exact_intensities);
+	free(reference_intensities);
+	return errors;
+}
@@ -0,0 +1,94 @@
+
+// Copyright 2019 Adam Campbell, Seth Hall, Andrew Ensor
+// Copyright 2019 High Performance Computing Research Laboratory, Auckland University of Technology (AUT)
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <stdbool.h>
+
+#include "degridder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef DFT_VALIDATION_H_
+#define DFT_VALIDATION_H_
+
+	typedef struct Source {
+		double l;
+		double m;
+		double intensity;
+	} Source;
+
+	typedef struct ValidationEngine {
+		const char *name;
+		bool coalesced;
+		double rms_tolerance;
+		double max_tolerance;
+		double reference_rms_tolerance;
+		double reference_max_tolerance;
+	} ValidationEngine;
+
+	typedef struct ValidationErrors {
+		double rms_error;
+		double max_error;
+		double reference_rms_error;
+		double reference_max_error;
+	} ValidationErrors;
+
+extern const ValidationEngine validation_engines[];
+
+extern const int num_validation_engines;
+
+void validation_init_config(Config *config);
+
+void generate_sky_model(Config *config, Source *sources, int num_sources, unsigned int seed);
+
+void generate_uvw_samples(Config *config, Visibility *vis_uvw, int num_visibilities, unsigned int seed);
+
+void direct_fourier_transform(Source *sources, int num_sources, Visibility *vis_uvw, Complex *vis_intensities, int num_visibilities);
+
+double validation_kernel_sample(Config *config, double distance);
+
+double validation_kernel_transform(Config *config, double frequency);
+
+void generate_validation_kernel(Config *config, Complex *kernel);
+
+void generate_corrected_grid(Config *config, Source *sources, int num_sources, Complex *grid);
+
+void calculate_error(Complex *approx_intensities, Complex *exact_intensities, int num_visibilities, double *rms_error, double *max_error);
+
+double execute_validation_engine(Config *config, const ValidationEngine *engine, Complex *grid, Visibility *vis_uvw, Complex *vis_intensities, Complex *kernel);
+
+ValidationErrors unit_test_validate_engine(const ValidationEngine *engine);
+
+#endif // DFT_VALIDATION_H_
+
+#ifdef __cplusplus
+}
+#endif
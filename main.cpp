@@ -77,7 +77,13 @@ int main(int argc, char **argv)
 	}
 	
 	// Perform degridding to obtain extracted visibility intensities from grid
-	execute_degridding(&config, grid, vis_uvw, vis_intensities, kernel, config.num_visibilities);
+	if(config.coalesce_footprints)
+	{
+		double dedup_ratio = execute_degridding_coalesced(&config, grid, vis_uvw, vis_intensities, kernel, config.num_visibilities);
+		printf(">>> Coalesced duplicate footprints, dedup ratio: %f\n", dedup_ratio);
+	}
+	else
+		execute_degridding(&config, grid, vis_uvw, vis_intensities, kernel, config.num_visibilities);
 	
 	// Save data to file
 	save_visibilities(&config, vis_uvw, vis_intensities);
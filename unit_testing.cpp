@@ -33,14 +33,50 @@
 #include <gtest/gtest.h>
 
 #include "degridder.h"
+#include "dft_validation.h"
 
-TEST(DegriddingTest, VisibilitiesApproximatelyEqual)
+// Disabled: the reference visibilities in ../data (not part of this repository)
+// were produced before the kernel offset was corrected to grid units with the
+// correct sign, so they no longer describe the degridder's output. Re-enable
+// once the reference has been regenerated with the current degridder.
+TEST(DegriddingTest, DISABLED_VisibilitiesApproximatelyEqual)
 {
 	double threshold = 1e-5; // 0.00001
 	double difference = unit_test_generate_approximate_visibilities();
 	ASSERT_LE(difference, threshold); // diff <= threshold
 }
 
+TEST(DegriddingTest, CoalescedFootprintsMatchDirectDegridding)
+{
+	double dedup_ratio = 0.0;
+	double difference = unit_test_coalesce_duplicate_footprints(64, &dedup_ratio);
+	ASSERT_EQ(difference, 0.0); // identical convolution, fanned out
+	ASSERT_DOUBLE_EQ(dedup_ratio, 8.0); // 64 visibilities, 8 unique footprints
+}
+
+TEST(DegriddingTest, CoalescedFootprintsMatchDirectDegriddingInChunks)
+{
+	double dedup_ratio = 0.0;
+	double difference = unit_test_coalesce_duplicate_footprints(16, &dedup_ratio);
+	ASSERT_EQ(difference, 0.0); // identical convolution, fanned out
+	ASSERT_DOUBLE_EQ(dedup_ratio, 2.0); // 4 chunks of 16 visibilities, 8 unique footprints each
+}
+
+TEST(DegriddingTest, EnginesWithinToleranceOfDirectFourierTransform)
+{
+	for(int engine_index = 0; engine_index < num_validation_engines; ++engine_index)
+	{
+		const ValidationEngine *engine = &validation_engines[engine_index];
+		ValidationErrors errors = unit_test_validate_engine(engine);
+		// Absolute accuracy against the direct fourier transform
+		ASSERT_LE(errors.rms_error, engine->rms_tolerance) << engine->name;
+		ASSERT_LE(errors.max_error, engine->max_tolerance) << engine->name;
+		// Accuracy cost relative to the direct double precision engine
+		ASSERT_LE(errors.reference_rms_error, engine->reference_rms_tolerance) << engine->name;
+		ASSERT_LE(errors.reference_max_error, engine->reference_max_tolerance) << engine->name;
+	}
+}
+
 int main(int argc, char **argv) {
 	testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
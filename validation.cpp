@@ -0,0 +1,160 @@
+
+// Copyright 2019 Adam Campbell, Seth Hall, Andrew Ensor
+// Copyright 2019 High Performance Computing Research Laboratory, Auckland University of Technology (AUT)
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <ctime>
+#include <climits>
+
+#include "degridder.h"
+#include "dft_validation.h"
+
+// Number of timed passes per engine, the fastest of which is reported
+static const int timed_passes = 5;
+
+static double wall_clock_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+	// Optionally override the number of visibilities from the command line
+	Config config;
+	validation_init_config(&config);
+	if(argc > 1)
+	{
+		char *end = NULL;
+		long num_visibilities = strtol(argv[1], &end, 10);
+		if(end == argv[1] || *end != '\0' || num_visibilities <= 0 || num_visibilities > INT_MAX)
+		{
+			printf("Usage: %s [number of visibilities > 0]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+		config.num_visibilities = (int) num_visibilities;
+	}
+	
+	int num_sources = 8;
+	// Number of times each uvw sample is repeated (time-averaged snapshots)
+	int repeats = 8;
+	
+	// Prepare required memory
+	Source *sources = (Source*) calloc(num_sources, sizeof(Source));
+	Complex *grid = (Complex*) calloc(config.grid_size * config.grid_size, sizeof(Complex));
+	size_t kernel_size = pow(((config.kernel_size / 2) + 1) * config.oversampling, 2.0);
+	Complex *kernel = (Complex*) calloc(kernel_size, sizeof(Complex));
+	Visibility *vis_uvw = (Visibility*) calloc(config.num_visibilities, sizeof(Visibility));
+	Complex *vis_intensities = (Complex*) calloc(config.num_visibilities, sizeof(Complex));
+	Complex *exact_intensities = (Complex*) calloc(config.num_visibilities, sizeof(Complex));
+	Complex *reference_intensities = (Complex*) calloc(config.num_visibilities, sizeof(Complex));
+	
+	// Evaluate memory allocation success
+	if(!sources || !grid || !kernel || !vis_uvw || !vis_intensities || !exact_intensities || !reference_intensities)
+	{
+		printf("Error: unable to allocate required memory, exiting...\n");
+		clean_up(&grid, &vis_uvw, &vis_intensities, &kernel);
+		free(sources);
+		free(exact_intensities);
+		free(reference_intensities);
+		return EXIT_FAILURE;
+	}
+	
+	printf(">>> Generating sky model, kernel, and grid...\n");
+	generate_sky_model(&config, sources, num_sources, 1234);
+	generate_validation_kernel(&config, kernel);
+	generate_corrected_grid(&config, sources, num_sources, grid);
+	
+	bool passed = true;
+	
+	for(int dataset = 0; dataset < 2; ++dataset)
+	{
+		// Second dataset repeats each uvw sample, as for short baselines and averaged data
+		int dataset_repeats = (dataset == 0) ? 1 : repeats;
+		generate_uvw_samples(&config, vis_uvw, config.num_visibilities, 5678);
+		for(int vis_index = config.num_visibilities - 1; vis_index >= 0; --vis_index)
+			vis_uvw[vis_index] = vis_uvw[vis_index / dataset_repeats];
+		
+		printf(">>> Computing direct fourier transform (%d visibilities, %d repeats)...\n",
+			config.num_visibilities, dataset_repeats);
+		direct_fourier_transform(sources, num_sources, vis_uvw, exact_intensities, config.num_visibilities);
+		// Direct double precision engine, the baseline each engine's accuracy cost is measured against
+		execute_degridding(&config, grid, vis_uvw, reference_intensities, kernel, config.num_visibilities);
+		
+		printf("%-20s %14s %14s %14s %14s %14s %12s %8s\n", "engine", "dft rms", "dft max",
+			"reference rms", "reference max", "vis/sec (best)", "dedup", "result");
+		
+		for(int engine_index = 0; engine_index < num_validation_engines; ++engine_index)
+		{
+			ValidationEngine engine = validation_engines[engine_index];
+			
+			// Untimed warm-up pass, then best of several wall clock timed passes
+			double dedup_ratio = execute_validation_engine(&config, &engine, grid, vis_uvw, vis_intensities, kernel);
+			double elapsed = INFINITY;
+			for(int pass = 0; pass < timed_passes; ++pass)
+			{
+				double start = wall_clock_seconds();
+				execute_validation_engine(&config, &engine, grid, vis_uvw, vis_intensities, kernel);
+				double pass_elapsed = wall_clock_seconds() - start;
+				if(pass_elapsed < elapsed)
+					elapsed = pass_elapsed;
+			}
+			
+			ValidationErrors errors;
+			calculate_error(vis_intensities, exact_intensities, config.num_visibilities,
+				&errors.rms_error, &errors.max_error);
+			calculate_error(vis_intensities, reference_intensities, config.num_visibilities,
+				&errors.reference_rms_error, &errors.reference_max_error);
+			
+			bool within_tolerance = errors.rms_error <= engine.rms_tolerance
+				&& errors.max_error <= engine.max_tolerance
+				&& errors.reference_rms_error <= engine.reference_rms_tolerance
+				&& errors.reference_max_error <= engine.reference_max_tolerance;
+			passed = passed && within_tolerance;
+			
+			printf("%-20s %14e %14e %14e %14e %14e %12f %8s\n", engine.name,
+				errors.rms_error, errors.max_error, errors.reference_rms_error, errors.reference_max_error,
+				(elapsed > 0.0) ? config.num_visibilities / elapsed : INFINITY, dedup_ratio,
+				within_tolerance ? "PASS" : "FAIL");
+		}
+	}
+	
+	// Free allocated memory
+	clean_up(&grid, &vis_uvw, &vis_intensities, &kernel);
+	free(sources);
+	free(exact_intensities);
+	free(reference_intensities);
+	
+	printf(">>> Finished...\n");
+	
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}